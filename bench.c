@@ -0,0 +1,383 @@
+// Microbenchmarks des fonctions critiques du cinéma et des clients.
+//
+// Compilation : gcc -O2 -o bench bench.c
+// Utilisation : ./bench [-e] [-s seuil_pourcent] [-b fichier_reference]
+//   -e : enregistre les résultats comme nouvelle référence
+//   -s : écart toléré en pourcentage sur les ns/op (25 par défaut)
+//   -b : fichier de référence (bench_baseline.txt par défaut)
+// Le programme se termine avec le code 1 si une mesure dépasse la référence.
+
+#include <getopt.h>
+#include <string.h>
+#include <time.h>
+
+// Inclusion des sources sans leurs fonctions main, pour mesurer le vrai code
+// (catalogue.h : format du fichier écrit par preparer_charger_catalogue)
+#define SANS_MAIN
+#include "cinema.c"
+#include "catalogue.h"
+
+// clients.c redéfinit des symboles déjà présents dans cinema.c : on les renomme
+#define NUM_CLIENTS 4096
+#define message message_client
+#define cleanup_done cleanup_done_client
+#define log_action log_action_client
+#define handle_sigint handle_sigint_client
+#include "clients.c"
+#undef message
+#undef cleanup_done
+#undef log_action
+#undef handle_sigint
+
+#define NB_REPETITIONS 5
+#define NB_MESURES_MAX 16
+#define NB_SALLES_BENCH 1024
+#define NB_PLACES_BENCH 2000
+#define NB_REQUETES 4096
+#define NB_SALLES_CATALOGUE 4096
+#define CHEMIN_CATALOGUE_BENCH "bench_catalogue.bin"
+
+// Structure pour représenter une mesure
+typedef struct {
+    char nom[64];
+    double ns_par_op;
+    double allocs_par_op;
+} Mesure;
+
+// Structure pour représenter un microbenchmark
+typedef struct {
+    const char *nom;
+    long nb_iterations;
+    void (*preparer)(void);
+    void (*executer)(long nb_iterations);
+} Benchmark;
+
+// Compteur d'allocations, alimenté par les fonctions d'allocation ci-dessous
+static long nb_allocations = 0;
+static volatile long puits = 0;
+
+static Salle salles_bench[NB_SALLES_BENCH];
+static Salle salle_bench;
+static SharedData *clients_bench = NULL;
+static int requetes[NB_REQUETES];
+
+// Remplacement des fonctions d'allocation de la glibc pour compter les allocations
+extern void *__libc_malloc(size_t taille);
+extern void *__libc_calloc(size_t nb, size_t taille);
+extern void *__libc_realloc(void *ptr, size_t taille);
+
+void *malloc(size_t taille) {
+    nb_allocations++;
+    return __libc_malloc(taille);
+}
+
+void *calloc(size_t nb, size_t taille) {
+    nb_allocations++;
+    return __libc_calloc(nb, taille);
+}
+
+void *realloc(void *ptr, size_t taille) {
+    nb_allocations++;
+    return __libc_realloc(ptr, taille);
+}
+
+// Fonction pour obtenir le temps courant en nanosecondes
+static long long maintenant_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Fonction pour préparer des requêtes pseudo-aléatoires reproductibles
+static void preparer_requetes(int modulo) {
+    srand(42);
+    for (int i = 0; i < NB_REQUETES; i++) {
+        requetes[i] = rand() % modulo;
+    }
+}
+
+// Recherche de la salle d'un film parmi les 4 salles du cinéma
+static void preparer_trouver_salle_4(void) {
+    for (int i = 0; i < NB_SALLES; i++) {
+        salles_bench[i].salle_id = i + 1;
+        salles_bench[i].film_id = i + 1;
+        salles_bench[i].nb_places_libres = 1;
+    }
+    preparer_requetes(NB_SALLES + 1);
+}
+
+static void executer_trouver_salle_4(long nb_iterations) {
+    long somme = 0;
+    for (long i = 0; i < nb_iterations; i++) {
+        somme += trouver_salle(salles_bench, NB_SALLES, requetes[i % NB_REQUETES]);
+    }
+    puits += somme;
+}
+
+// Recherche de la salle d'un film parmi un grand nombre de salles
+static void preparer_trouver_salle_n(void) {
+    for (int i = 0; i < NB_SALLES_BENCH; i++) {
+        salles_bench[i].salle_id = i + 1;
+        salles_bench[i].film_id = i;
+        salles_bench[i].nb_places_libres = 1;
+    }
+    preparer_requetes(NB_SALLES_BENCH);
+}
+
+static void executer_trouver_salle_n(long nb_iterations) {
+    long somme = 0;
+    for (long i = 0; i < nb_iterations; i++) {
+        somme += trouver_salle(salles_bench, NB_SALLES_BENCH, requetes[i % NB_REQUETES]);
+    }
+    puits += somme;
+}
+
+// Attribution des places d'une grande salle, remise à zéro quand elle est pleine
+static void preparer_attribuer_place(void) {
+    if (salle_bench.client_pid == NULL) {
+        salle_bench = create_salle(1, NB_PLACES_BENCH, 1, 0);
+    }
+    salle_bench.nb_places_libres = salle_bench.nb_places;
+}
+
+static void executer_attribuer_place(long nb_iterations) {
+    for (long i = 0; i < nb_iterations; i++) {
+        if (!attribuer_place(&salle_bench, (pid_t)i)) {
+            salle_bench.nb_places_libres = salle_bench.nb_places;
+        }
+    }
+    puits += salle_bench.nb_places_libres;
+}
+
+// Encodage de la réponse envoyée au client
+static void preparer_encoder_confirmation(void) {
+    preparer_requetes(3);
+}
+
+static void executer_encoder_confirmation(long nb_iterations) {
+    long somme = 0;
+    for (long i = 0; i < nb_iterations; i++) {
+        somme += encoder_confirmation((int)(i & 0xFF), (ReservationStatus)requetes[i % NB_REQUETES]);
+    }
+    puits += somme;
+}
+
+// Recherche d'un client dans la mémoire partagée à partir de son PID
+static void preparer_trouver_client(void) {
+    if (clients_bench == NULL) {
+        clients_bench = __libc_malloc(sizeof(SharedData));
+    }
+    for (int i = 0; i < NUM_CLIENTS; i++) {
+        clients_bench->clients[i].id = 1000 + i;
+    }
+    preparer_requetes(NUM_CLIENTS);
+}
+
+static void executer_trouver_client(long nb_iterations) {
+    long somme = 0;
+    for (long i = 0; i < nb_iterations; i++) {
+        Client *client = trouver_client(clients_bench, 1000 + requetes[i % NB_REQUETES]);
+        somme += client != NULL ? client->id : 0;
+    }
+    puits += somme;
+}
+
+// Écriture d'une ligne dans le fichier de log (dans un répertoire temporaire)
+static void preparer_log_action(void) {
+}
+
+static void executer_log_action(long nb_iterations) {
+    for (long i = 0; i < nb_iterations; i++) {
+        log_action("Client 1234 a réservé une place dans la salle 1\n");
+    }
+}
+
+// Chargement d'un catalogue de plusieurs milliers de salles (écrit dans le répertoire temporaire)
+static void preparer_charger_catalogue(void) {
+    FILE *fichier = fopen(CHEMIN_CATALOGUE_BENCH, "wb");
+    if (fichier == NULL) {
+        perror("Erreur lors de l'écriture du catalogue de test");
+        exit(2);
+    }
+    EnteteCatalogue entete = {CATALOGUE_MAGIC, CATALOGUE_VERSION, 2, NB_SALLES_CATALOGUE, NB_SALLES_CATALOGUE, NB_SALLES_CATALOGUE * 200};
+    FilmCatalogue films_bench[2] = {{1, 0, "Film 1"}, {2, 12, "Film 2"}};
+    fwrite(&entete, sizeof(entete), 1, fichier);
+    fwrite(films_bench, sizeof(FilmCatalogue), 2, fichier);
+    for (int i = 0; i < NB_SALLES_CATALOGUE; i++) {
+        SalleCatalogue salle = {i + 1, 10, 20, 1 + i % 2};
+        fwrite(&salle, sizeof(salle), 1, fichier);
+    }
+    for (int i = 0; i < NB_SALLES_CATALOGUE; i++) {
+        SeanceCatalogue seance = {i + 1, 1 + i % 2, 20 * 60};
+        fwrite(&seance, sizeof(seance), 1, fichier);
+    }
+    fclose(fichier);
+}
+
+static void executer_charger_catalogue(long nb_iterations) {
+    for (long i = 0; i < nb_iterations; i++) {
+        if (charger_catalogue(CHEMIN_CATALOGUE_BENCH) < 0) {
+            perror("Erreur lors du chargement du catalogue de test");
+            exit(2);
+        }
+        puits += nb_salles;
+        liberer_catalogue();
+    }
+}
+
+static const Benchmark benchmarks[] = {
+    {"trouver_salle/4", 20000000, preparer_trouver_salle_4, executer_trouver_salle_4},
+    {"trouver_salle/1024", 200000, preparer_trouver_salle_n, executer_trouver_salle_n},
+    {"attribuer_place/2000", 20000000, preparer_attribuer_place, executer_attribuer_place},
+    {"encoder_confirmation", 20000000, preparer_encoder_confirmation, executer_encoder_confirmation},
+    {"trouver_client/4096", 100000, preparer_trouver_client, executer_trouver_client},
+    {"log_action", 20000, preparer_log_action, executer_log_action},
+    {"charger_catalogue/4096", 200, preparer_charger_catalogue, executer_charger_catalogue},
+};
+
+// Fonction pour mesurer un benchmark (meilleur temps sur plusieurs répétitions)
+static Mesure mesurer(const Benchmark *benchmark) {
+    Mesure mesure;
+    snprintf(mesure.nom, sizeof(mesure.nom), "%s", benchmark->nom);
+    mesure.ns_par_op = -1;
+    mesure.allocs_par_op = 0;
+
+    for (int r = 0; r < NB_REPETITIONS; r++) {
+        benchmark->preparer();
+        long allocations_avant = nb_allocations;
+        long long debut = maintenant_ns();
+        benchmark->executer(benchmark->nb_iterations);
+        long long fin = maintenant_ns();
+        double ns_par_op = (double)(fin - debut) / benchmark->nb_iterations;
+        double allocs_par_op = (double)(nb_allocations - allocations_avant) / benchmark->nb_iterations;
+        if (mesure.ns_par_op < 0 || ns_par_op < mesure.ns_par_op) {
+            mesure.ns_par_op = ns_par_op;
+        }
+        mesure.allocs_par_op = allocs_par_op;
+    }
+    return mesure;
+}
+
+// Fonction pour lire le fichier de référence (renvoie le nombre de mesures lues)
+static int lire_reference(const char *chemin, Mesure reference[], int max) {
+    FILE *fichier = fopen(chemin, "r");
+    if (fichier == NULL) {
+        return -1;
+    }
+    int nb = 0;
+    while (nb < max && fscanf(fichier, "%63s %lf %lf", reference[nb].nom, &reference[nb].ns_par_op, &reference[nb].allocs_par_op) == 3) {
+        nb++;
+    }
+    fclose(fichier);
+    return nb;
+}
+
+// Fonction pour écrire le fichier de référence
+static int ecrire_reference(const char *chemin, Mesure mesures[], int nb) {
+    FILE *fichier = fopen(chemin, "w");
+    if (fichier == NULL) {
+        perror("Erreur lors de l'ouverture du fichier de référence");
+        return -1;
+    }
+    for (int i = 0; i < nb; i++) {
+        fprintf(fichier, "%s %.2f %.4f\n", mesures[i].nom, mesures[i].ns_par_op, mesures[i].allocs_par_op);
+    }
+    fclose(fichier);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    const char *chemin_reference = "bench_baseline.txt";
+    bool enregistrer = false;
+    double seuil = 25.0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "eb:s:")) != -1) {
+        switch (opt) {
+            case 'e':
+                enregistrer = true;
+                break;
+            case 'b':
+                chemin_reference = optarg;
+                break;
+            case 's':
+                seuil = atof(optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage : %s [-e] [-s seuil_pourcent] [-b fichier_reference]\n", argv[0]);
+                return 2;
+        }
+    }
+
+    // Chemin absolu de la référence, le répertoire courant change pour log_action
+    char chemin_absolu[4096];
+    if (chemin_reference[0] != '/' && getcwd(chemin_absolu, sizeof(chemin_absolu)) != NULL) {
+        size_t longueur = strlen(chemin_absolu);
+        snprintf(chemin_absolu + longueur, sizeof(chemin_absolu) - longueur, "/%s", chemin_reference);
+        chemin_reference = chemin_absolu;
+    }
+
+    // Répertoire temporaire pour que log_action n'écrive pas dans le vrai log.txt
+    char repertoire[] = "/tmp/cinema_bench_XXXXXX";
+    if (mkdtemp(repertoire) == NULL || chdir(repertoire) < 0) {
+        perror("Erreur lors de la création du répertoire temporaire");
+        return 2;
+    }
+
+    int nb_benchmarks = sizeof(benchmarks) / sizeof(benchmarks[0]);
+    Mesure mesures[NB_MESURES_MAX];
+    Mesure reference[NB_MESURES_MAX];
+    int nb_reference = lire_reference(chemin_reference, reference, NB_MESURES_MAX);
+    int nb_regressions = 0;
+
+    printf("%-24s %12s %12s %12s\n", "benchmark", "ns/op", "allocs/op", "référence");
+    for (int i = 0; i < nb_benchmarks; i++) {
+        mesures[i] = mesurer(&benchmarks[i]);
+
+        // Recherche de la mesure de référence correspondante
+        Mesure *ref = NULL;
+        for (int j = 0; j < nb_reference; j++) {
+            if (strcmp(reference[j].nom, mesures[i].nom) == 0) {
+                ref = &reference[j];
+                break;
+            }
+        }
+
+        bool regression = false;
+        if (ref != NULL && !enregistrer) {
+            regression = mesures[i].ns_par_op > ref->ns_par_op * (1.0 + seuil / 100.0)
+                || mesures[i].allocs_par_op > ref->allocs_par_op + 0.001;
+        }
+        if (regression) {
+            nb_regressions++;
+        }
+
+        if (ref != NULL) {
+            printf("%-24s %12.2f %12.4f %12.2f%s\n", mesures[i].nom, mesures[i].ns_par_op, mesures[i].allocs_par_op, ref->ns_par_op, regression ? "  REGRESSION" : "");
+        } else {
+            printf("%-24s %12.2f %12.4f %12s\n", mesures[i].nom, mesures[i].ns_par_op, mesures[i].allocs_par_op, "-");
+        }
+    }
+
+    // Nettoyage du répertoire temporaire
+    unlink("log.txt");
+    unlink(CHEMIN_CATALOGUE_BENCH);
+    if (chdir("/") == 0) {
+        rmdir(repertoire);
+    }
+
+    if (enregistrer) {
+        if (ecrire_reference(chemin_reference, mesures, nb_benchmarks) < 0) {
+            return 2;
+        }
+        printf("Référence enregistrée dans %s\n", chemin_reference);
+        return 0;
+    }
+    if (nb_reference < 0) {
+        printf("Aucune référence trouvée dans %s (utiliser -e pour l'enregistrer)\n", chemin_reference);
+    } else if (nb_regressions > 0) {
+        printf("%d régression(s) au-delà de %.0f%%\n", nb_regressions, seuil);
+        return 1;
+    }
+    return 0;
+}
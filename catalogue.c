@@ -0,0 +1,227 @@
+// Compilateur du catalogue : transforme une description texte des films, salles et séances
+// en fichier binaire chargé par cinema.c.
+//
+// Compilation : gcc -o catalogue catalogue.c
+// Utilisation : ./catalogue catalogue.txt catalogue.bin
+//
+// Format du fichier texte (une entrée par ligne, '#' pour les commentaires) :
+//   film <film_id> <age_limite> <titre>
+//   salle <salle_id> <nb_rangees> <places_par_rangee> <film_id>
+//   seance <salle_id> <film_id> <HH:MM>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "catalogue.h"
+
+FilmCatalogue *films = NULL;
+SalleCatalogue *salles = NULL;
+SeanceCatalogue *seances = NULL;
+int nb_films = 0, nb_salles = 0, nb_seances = 0;
+int capacite_films = 0, capacite_salles = 0, capacite_seances = 0;
+
+// Prototypes des fonctions
+int lire_description(FILE *fichier);
+int verifier_catalogue(void);
+int ecrire_catalogue(const char *chemin);
+void *agrandir(void *tableau, int *capacite, int nb, size_t taille);
+int comparer_id(const void *a, const void *b);
+void erreur_ligne(int numero_ligne, const char *message);
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage : %s <description.txt> <catalogue.bin>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *fichier = fopen(argv[1], "r");
+    if (fichier == NULL) {
+        perror("Erreur lors de l'ouverture de la description");
+        return 1;
+    }
+    int resultat = lire_description(fichier);
+    fclose(fichier);
+    if (resultat < 0 || verifier_catalogue() < 0 || ecrire_catalogue(argv[2]) < 0) {
+        return 1;
+    }
+
+    printf("Catalogue %s écrit : %d films, %d salles, %d séances\n", argv[2], nb_films, nb_salles, nb_seances);
+    free(films);
+    free(salles);
+    free(seances);
+    return 0;
+}
+
+// Fonction pour lire la description texte du catalogue
+int lire_description(FILE *fichier) {
+    char ligne[256];
+    int numero_ligne = 0;
+
+    while (fgets(ligne, sizeof(ligne), fichier) != NULL) {
+        numero_ligne++;
+        char type[16];
+        int lus;
+        if (sscanf(ligne, "%15s%n", type, &lus) != 1 || type[0] == '#') {
+            continue; // Ligne vide ou commentaire
+        }
+        char *suite = ligne + lus;
+
+        if (strcmp(type, "film") == 0) {
+            films = agrandir(films, &capacite_films, nb_films, sizeof(FilmCatalogue));
+            FilmCatalogue *film = &films[nb_films];
+            memset(film, 0, sizeof(*film));
+            if (sscanf(suite, "%d %d %31[^\n]", &film->film_id, &film->age_limite, film->titre) < 2) {
+                erreur_ligne(numero_ligne, "film attendu : film <film_id> <age_limite> <titre>");
+                return -1;
+            }
+            nb_films++;
+        } else if (strcmp(type, "salle") == 0) {
+            salles = agrandir(salles, &capacite_salles, nb_salles, sizeof(SalleCatalogue));
+            SalleCatalogue *salle = &salles[nb_salles];
+            if (sscanf(suite, "%d %d %d %d", &salle->salle_id, &salle->nb_rangees, &salle->places_par_rangee, &salle->film_id) != 4) {
+                erreur_ligne(numero_ligne, "salle attendue : salle <salle_id> <nb_rangees> <places_par_rangee> <film_id>");
+                return -1;
+            }
+            if (salle->nb_rangees <= 0 || salle->places_par_rangee <= 0) {
+                erreur_ligne(numero_ligne, "une salle doit avoir au moins une rangée et une place par rangée");
+                return -1;
+            }
+            nb_salles++;
+        } else if (strcmp(type, "seance") == 0) {
+            seances = agrandir(seances, &capacite_seances, nb_seances, sizeof(SeanceCatalogue));
+            SeanceCatalogue *seance = &seances[nb_seances];
+            int heures, minutes;
+            if (sscanf(suite, "%d %d %d:%d", &seance->salle_id, &seance->film_id, &heures, &minutes) != 4
+                || heures < 0 || heures > 23 || minutes < 0 || minutes > 59) {
+                erreur_ligne(numero_ligne, "séance attendue : seance <salle_id> <film_id> <HH:MM>");
+                return -1;
+            }
+            seance->heure = heures * 60 + minutes;
+            nb_seances++;
+        } else {
+            erreur_ligne(numero_ligne, "type d'entrée inconnu (film, salle ou seance)");
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Fonction pour vérifier la cohérence du catalogue (identifiants uniques, références existantes)
+int verifier_catalogue(void) {
+    // Les films sont triés pour que cinema.c puisse les rechercher par dichotomie
+    qsort(films, nb_films, sizeof(FilmCatalogue), comparer_id);
+    for (int i = 1; i < nb_films; i++) {
+        if (films[i].film_id == films[i - 1].film_id) {
+            fprintf(stderr, "Film %d défini plusieurs fois\n", films[i].film_id);
+            return -1;
+        }
+    }
+
+    // Copie des salles triée par identifiant pour les vérifications
+    SalleCatalogue *salles_triees = malloc((nb_salles > 0 ? nb_salles : 1) * sizeof(SalleCatalogue));
+    if (salles_triees == NULL) {
+        perror("Erreur lors de l'allocation");
+        return -1;
+    }
+    long nb_places_total = 0;
+    for (int i = 0; i < nb_salles; i++) {
+        salles_triees[i] = salles[i];
+        nb_places_total += (long)salles[i].nb_rangees * salles[i].places_par_rangee;
+        if (bsearch(&salles[i].film_id, films, nb_films, sizeof(FilmCatalogue), comparer_id) == NULL) {
+            fprintf(stderr, "Salle %d : film %d inconnu\n", salles[i].salle_id, salles[i].film_id);
+            free(salles_triees);
+            return -1;
+        }
+    }
+    if (nb_places_total > 0x7FFFFFFF) {
+        fprintf(stderr, "Nombre total de places trop grand\n");
+        free(salles_triees);
+        return -1;
+    }
+    qsort(salles_triees, nb_salles, sizeof(SalleCatalogue), comparer_id);
+    for (int i = 1; i < nb_salles; i++) {
+        if (salles_triees[i].salle_id == salles_triees[i - 1].salle_id) {
+            fprintf(stderr, "Salle %d définie plusieurs fois\n", salles_triees[i].salle_id);
+            free(salles_triees);
+            return -1;
+        }
+    }
+
+    // Une séance doit projeter le film de sa salle
+    for (int i = 0; i < nb_seances; i++) {
+        SalleCatalogue *salle = bsearch(&seances[i].salle_id, salles_triees, nb_salles, sizeof(SalleCatalogue), comparer_id);
+        if (salle == NULL) {
+            fprintf(stderr, "Séance %d : salle %d inconnue\n", i + 1, seances[i].salle_id);
+            free(salles_triees);
+            return -1;
+        }
+        if (seances[i].film_id != salle->film_id) {
+            fprintf(stderr, "Séance %d : la salle %d projette le film %d, pas le film %d\n", i + 1, salle->salle_id, salle->film_id, seances[i].film_id);
+            free(salles_triees);
+            return -1;
+        }
+    }
+    free(salles_triees);
+    return 0;
+}
+
+// Fonction pour écrire le catalogue binaire
+int ecrire_catalogue(const char *chemin) {
+    EnteteCatalogue entete;
+    entete.magic = CATALOGUE_MAGIC;
+    entete.version = CATALOGUE_VERSION;
+    entete.nb_films = nb_films;
+    entete.nb_salles = nb_salles;
+    entete.nb_seances = nb_seances;
+    entete.nb_places_total = 0;
+    for (int i = 0; i < nb_salles; i++) {
+        entete.nb_places_total += salles[i].nb_rangees * salles[i].places_par_rangee;
+    }
+
+    FILE *fichier = fopen(chemin, "wb");
+    if (fichier == NULL) {
+        perror("Erreur lors de l'ouverture du catalogue");
+        return -1;
+    }
+    if (fwrite(&entete, sizeof(entete), 1, fichier) != 1
+        || fwrite(films, sizeof(FilmCatalogue), nb_films, fichier) != (size_t)nb_films
+        || fwrite(salles, sizeof(SalleCatalogue), nb_salles, fichier) != (size_t)nb_salles
+        || fwrite(seances, sizeof(SeanceCatalogue), nb_seances, fichier) != (size_t)nb_seances) {
+        perror("Erreur lors de l'écriture du catalogue");
+        fclose(fichier);
+        return -1;
+    }
+    if (fclose(fichier) != 0) {
+        perror("Erreur lors de l'écriture du catalogue");
+        return -1;
+    }
+    return 0;
+}
+
+// Fonction pour agrandir un tableau dynamique si nécessaire
+void *agrandir(void *tableau, int *capacite, int nb, size_t taille) {
+    if (nb < *capacite) {
+        return tableau;
+    }
+    int nouvelle_capacite = *capacite > 0 ? *capacite * 2 : 16;
+    void *agrandi = realloc(tableau, nouvelle_capacite * taille);
+    if (agrandi == NULL) {
+        perror("Erreur lors de l'allocation");
+        exit(1);
+    }
+    *capacite = nouvelle_capacite;
+    return agrandi;
+}
+
+// Fonction de comparaison sur le premier champ (identifiant) d'un film ou d'une salle
+int comparer_id(const void *a, const void *b) {
+    int id_a = *(const int *)a;
+    int id_b = *(const int *)b;
+    return (id_a > id_b) - (id_a < id_b);
+}
+
+// Fonction pour signaler une erreur dans la description
+void erreur_ligne(int numero_ligne, const char *message) {
+    fprintf(stderr, "Ligne %d : %s\n", numero_ligne, message);
+}
@@ -0,0 +1,42 @@
+#ifndef CATALOGUE_H
+#define CATALOGUE_H
+
+// Format du catalogue binaire écrit par catalogue.c et projeté en mémoire par cinema.c
+
+#define CATALOGUE_MAGIC 0x454E4943 // "CINE"
+#define CATALOGUE_VERSION 1
+
+// En-tête du fichier catalogue, suivi des films (triés par identifiant), des salles puis
+// des séances, dans l'ordre de la machine
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    int nb_films;
+    int nb_salles;
+    int nb_seances;
+    int nb_places_total;
+} EnteteCatalogue;
+
+// Structure pour un film du catalogue
+typedef struct {
+    int film_id;
+    int age_limite;
+    char titre[32];
+} FilmCatalogue;
+
+// Structure pour une salle du catalogue
+typedef struct {
+    int salle_id;
+    int nb_rangees;
+    int places_par_rangee;
+    int film_id;
+} SalleCatalogue;
+
+// Structure pour une séance du catalogue, heure en minutes depuis minuit
+typedef struct {
+    int salle_id;
+    int film_id;
+    int heure;
+} SeanceCatalogue;
+
+#endif
@@ -7,14 +7,19 @@
 #include <stdbool.h>
 #include <sys/wait.h>
 #include <sys/file.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
 
-// Structure pour les messages échangés entre les processus
-struct message {
-    long message_type;
-    int pid;
-    int film_id;
-    int age;
-};
+#include "site.h"
+#include "catalogue.h"
+
+#define NB_SALLES 4
+#define CHEMIN_CATALOGUE "catalogue.bin"
 
 // Structure pour représenter une salle
 typedef struct {
@@ -23,7 +28,10 @@ typedef struct {
     int nb_places_libres;
     int film_id;
     int age_limite;
+    int nb_rangees;
     int *client_pid;
+    bool places_arena;
+    pid_t pid_processus;
 } Salle;
 
 // Enumération pour les différents statuts de réservation
@@ -33,71 +41,309 @@ typedef enum {
     AGE_LIMITE
 } ReservationStatus;
 
-// Création de salles
-Salle salles[4];
+// Création de salles : tableau contigu, places de toutes les salles prises dans une seule arène
+Salle *salles = NULL;
+int nb_salles = 0;
+int capacite_salles = 0;
+int *arena_places = NULL;
+
+// Catalogue projeté en mémoire (films et séances restent lus directement dans le fichier)
+void *catalogue = NULL;
+size_t taille_catalogue = 0;
+const FilmCatalogue *films = NULL;
+int nb_films = 0;
+const SeanceCatalogue *seances = NULL;
+int nb_seances = 0;
+
+// Chemin de la socket du site (vide si le cinéma ne fonctionne pas en mode site)
+char chemin_socket[108] = "";
+
+// Socket d'écoute du site et connexion en cours, fermées dans les processus des salles
+int socket_site = -1;
+int connexion_site = -1;
 
 volatile sig_atomic_t cleanup_done = 0;
 
 // Prototypes des fonctions
 Salle create_salle(int salle_id, int nb_places, int film_id, int age_limite);
+Salle create_salle_arena(int salle_id, int nb_places, int film_id, int age_limite, int *places);
+int charger_catalogue(const char *chemin);
+void charger_salles_par_defaut(void);
+int comparer_film(const void *cle, const void *film);
+void liberer_catalogue(void);
 void recevoir_message(Salle salle[]);
+int traiter_reservation(Salle salles[], int nb_salles, struct message *msg);
+void garder_salles(char *salle_ids[], int nb_ids);
+void lancer_salle(Salle *salle);
+void servir_site(int numero_site);
+void traiter_requete_site(int connexion);
+EtatSalle etat_salle(Salle *salle);
+int lire_tout(int fd, void *buffer, size_t taille);
+int ecrire_tout(int fd, const void *buffer, size_t taille);
+int trouver_salle(Salle salles[], int nb_salles, int film_id);
+bool attribuer_place(Salle *salle, pid_t client_pid);
+int encoder_confirmation(int salle_id, ReservationStatus status);
 void envoyer_confirmation_reservation(pid_t client_pid, int salle_id, ReservationStatus status);
 void envoyer_signal_avec_cle(pid_t client_pid, int cle_salle, int type_evenement);
 void salle_process(Salle salle);
+int attente_prochaine_seance(int salle_id);
 void log_action(const char *message);
 void reset_salle(Salle *salle);
 void delete_salle(Salle *salle);
 void handle_sigint(int sig);
 
-int main() {
+#ifndef SANS_MAIN
+int main(int argc, char *argv[]) {
     struct sigaction sa;
     sa.sa_handler = handle_sigint;
     sigemptyset(&sa.sa_mask);
     sa.sa_flags = 0;
     sigaction(SIGINT, &sa, NULL);
 
-    salles[0] = create_salle(1, 20, 1, 18);
-    salles[1] = create_salle(2, 20, 2, 12);
-    salles[2] = create_salle(3, 20, 3, 8);
-    salles[3] = create_salle(4, 20, 4, 18);
+    // "-c <fichier>" : catalogue à charger à la place de catalogue.bin
+    // "-s <numero_site> <salle_id>..." : mode site, ne garde que les salles indiquées
+    // et reçoit les requêtes du routeur sur une socket UNIX au lieu de la file de messages
+    const char *chemin_catalogue = CHEMIN_CATALOGUE;
+    bool catalogue_explicite = false;
+    int numero_site = -1;
+    int opt;
+    while ((opt = getopt(argc, argv, "c:s:")) != -1) {
+        switch (opt) {
+            case 'c':
+                chemin_catalogue = optarg;
+                catalogue_explicite = true;
+                break;
+            case 's':
+                numero_site = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr, "Usage : %s [-c catalogue] [-s numero_site salle_id...]\n", argv[0]);
+                exit(1);
+        }
+    }
+
+    if (charger_catalogue(chemin_catalogue) == 0) {
+        printf("Catalogue %s chargé : %d films, %d salles, %d séances\n", chemin_catalogue, nb_films, nb_salles, nb_seances);
+    } else if (catalogue_explicite) {
+        // Un catalogue demandé avec -c doit exister : pas de repli sur les salles par défaut
+        fprintf(stderr, "Catalogue %s introuvable\n", chemin_catalogue);
+        exit(1);
+    } else {
+        printf("Catalogue %s introuvable, utilisation des salles par défaut\n", chemin_catalogue);
+        charger_salles_par_defaut();
+    }
+    if (numero_site >= 0) {
+        garder_salles(argv + optind, argc - optind);
+    }
     printf("Salles créées\n");
 
     // Création de processus pour chaque salle
-    for (int i = 0; i < 4; i++) {
-        pid_t pid = fork();
-        if (pid == 0) {
-            salle_process(salles[i]);
-            exit(0);
-        }
+    for (int i = 0; i < nb_salles; i++) {
+        lancer_salle(&salles[i]);
     }
 
-    // Simulation de réception de message
-    recevoir_message(salles);
+    if (numero_site >= 0) {
+        servir_site(numero_site);
+    } else {
+        // Simulation de réception de message
+        recevoir_message(salles);
+    }
 
     // Attendre la fin des processus enfants
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < nb_salles; i++) {
         wait(NULL);
     }
 
     // Libérer la mémoire allouée pour les salles
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < nb_salles; i++) {
         delete_salle(&salles[i]);
     }
+    liberer_catalogue();
     return 0;
 }
+#endif
 
 // Fonction pour créer une salle
 Salle create_salle(int salle_id, int nb_places, int film_id, int age_limite) {
+    Salle salle = create_salle_arena(salle_id, nb_places, film_id, age_limite, malloc(nb_places * sizeof(int)));
+    salle.places_arena = false;
+    return salle;
+}
+
+// Fonction pour créer une salle dont les places sont prises dans l'arène commune
+Salle create_salle_arena(int salle_id, int nb_places, int film_id, int age_limite, int *places) {
     Salle salle;
     salle.salle_id = salle_id;
     salle.nb_places = nb_places;
     salle.nb_places_libres = nb_places;
     salle.film_id = film_id;
     salle.age_limite = age_limite;
-    salle.client_pid = malloc(nb_places * sizeof(int));
+    salle.nb_rangees = 1;
+    salle.client_pid = places;
+    salle.places_arena = true;
+    salle.pid_processus = 0;
     return salle;
 }
 
+// Fonction pour charger les salles depuis un catalogue binaire projeté en mémoire
+// (renvoie -1 si le fichier n'existe pas, quitte le programme s'il est invalide)
+int charger_catalogue(const char *chemin) {
+    int fd = open(chemin, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        perror("Erreur lors de la lecture du catalogue");
+        exit(1);
+    }
+    if ((size_t)st.st_size < sizeof(EnteteCatalogue)) {
+        fprintf(stderr, "Catalogue %s invalide : fichier trop court\n", chemin);
+        exit(1);
+    }
+    void *donnees = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (donnees == MAP_FAILED) {
+        perror("Erreur lors de la projection du catalogue");
+        exit(1);
+    }
+
+    // Vérification de l'en-tête et de la taille annoncée
+    const EnteteCatalogue *entete = donnees;
+    size_t taille_attendue = sizeof(EnteteCatalogue)
+        + (size_t)entete->nb_films * sizeof(FilmCatalogue)
+        + (size_t)entete->nb_salles * sizeof(SalleCatalogue)
+        + (size_t)entete->nb_seances * sizeof(SeanceCatalogue);
+    if (entete->magic != CATALOGUE_MAGIC || entete->version != CATALOGUE_VERSION
+        || entete->nb_films < 0 || entete->nb_salles < 0 || entete->nb_seances < 0
+        || entete->nb_places_total < 0 || taille_attendue != (size_t)st.st_size) {
+        fprintf(stderr, "Catalogue %s invalide : en-tête incorrect\n", chemin);
+        exit(1);
+    }
+    films = (const FilmCatalogue *)(entete + 1);
+    nb_films = entete->nb_films;
+    const SalleCatalogue *salles_catalogue = (const SalleCatalogue *)(films + nb_films);
+    seances = (const SeanceCatalogue *)(salles_catalogue + entete->nb_salles);
+    nb_seances = entete->nb_seances;
+
+    // Un seul tableau de salles et une seule arène pour les places de toutes les salles
+    capacite_salles = entete->nb_salles > 0 ? entete->nb_salles : 1;
+    salles = malloc(capacite_salles * sizeof(Salle));
+    arena_places = calloc(entete->nb_places_total > 0 ? entete->nb_places_total : 1, sizeof(int));
+    if (salles == NULL || arena_places == NULL) {
+        perror("Erreur lors de l'allocation des salles");
+        exit(1);
+    }
+
+    int *places = arena_places;
+    int places_restantes = entete->nb_places_total;
+    for (int i = 0; i < entete->nb_salles; i++) {
+        const SalleCatalogue *salle = &salles_catalogue[i];
+        // Produit calculé en long pour qu'un catalogue corrompu ne déborde pas de l'arène
+        long nb_places_salle = (long)salle->nb_rangees * salle->places_par_rangee;
+        if (salle->nb_rangees <= 0 || salle->places_par_rangee <= 0
+            || nb_places_salle <= 0 || nb_places_salle > places_restantes) {
+            fprintf(stderr, "Catalogue %s invalide : salle %d incorrecte\n", chemin, salle->salle_id);
+            exit(1);
+        }
+        int nb_places = (int)nb_places_salle;
+        // Sans son film, la salle perdrait sa limite d'âge : catalogue refusé
+        const FilmCatalogue *film = bsearch(&salle->film_id, films, nb_films, sizeof(FilmCatalogue), comparer_film);
+        if (film == NULL) {
+            fprintf(stderr, "Catalogue %s invalide : film %d de la salle %d introuvable\n", chemin, salle->film_id, salle->salle_id);
+            exit(1);
+        }
+        salles[i] = create_salle_arena(salle->salle_id, nb_places, salle->film_id, film->age_limite, places);
+        salles[i].nb_rangees = salle->nb_rangees;
+        places += nb_places;
+        places_restantes -= nb_places;
+    }
+    nb_salles = entete->nb_salles;
+
+    catalogue = donnees;
+    taille_catalogue = st.st_size;
+    return 0;
+}
+
+// Fonction pour créer les salles par défaut, en l'absence de catalogue
+void charger_salles_par_defaut(void) {
+    capacite_salles = NB_SALLES;
+    salles = malloc(capacite_salles * sizeof(Salle));
+    arena_places = calloc(NB_SALLES * 20, sizeof(int));
+    if (salles == NULL || arena_places == NULL) {
+        perror("Erreur lors de l'allocation des salles");
+        exit(1);
+    }
+    salles[0] = create_salle_arena(1, 20, 1, 18, arena_places);
+    salles[1] = create_salle_arena(2, 20, 2, 12, arena_places + 20);
+    salles[2] = create_salle_arena(3, 20, 3, 8, arena_places + 40);
+    salles[3] = create_salle_arena(4, 20, 4, 18, arena_places + 60);
+    nb_salles = NB_SALLES;
+    for (int i = 0; i < NB_SALLES; i++) {
+        salles[i].nb_rangees = 4;
+    }
+}
+
+// Fonction de comparaison pour la recherche d'un film par identifiant
+int comparer_film(const void *cle, const void *film) {
+    int film_id = *(const int *)cle;
+    int autre_id = ((const FilmCatalogue *)film)->film_id;
+    return (film_id > autre_id) - (film_id < autre_id);
+}
+
+// Fonction pour libérer le tableau des salles, l'arène des places et le catalogue
+void liberer_catalogue(void) {
+    free(salles);
+    salles = NULL;
+    nb_salles = 0;
+    capacite_salles = 0;
+    free(arena_places);
+    arena_places = NULL;
+    if (catalogue != NULL) {
+        munmap(catalogue, taille_catalogue);
+        catalogue = NULL;
+        films = NULL;
+        seances = NULL;
+    }
+}
+
+// Fonction pour ne garder que les salles dont l'identifiant est donné (mode site)
+void garder_salles(char *salle_ids[], int nb_ids) {
+    int nb_gardees = 0;
+    for (int i = 0; i < nb_salles; i++) {
+        bool gardee = false;
+        for (int j = 0; j < nb_ids; j++) {
+            if (atoi(salle_ids[j]) == salles[i].salle_id) {
+                gardee = true;
+                break;
+            }
+        }
+        if (gardee) {
+            salles[nb_gardees++] = salles[i];
+        } else {
+            delete_salle(&salles[i]);
+        }
+    }
+    nb_salles = nb_gardees;
+}
+
+// Fonction pour lancer le processus d'une salle
+void lancer_salle(Salle *salle) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        // Le processus de la salle ne doit pas garder les sockets du site ouvertes
+        if (socket_site >= 0) {
+            close(socket_site);
+        }
+        if (connexion_site >= 0) {
+            close(connexion_site);
+        }
+        salle_process(*salle);
+        exit(0);
+    }
+    salle->pid_processus = pid;
+}
+
 // Fonction pour recevoir un message d'une file de messages
 void recevoir_message(Salle salles[]) {
     int msgid, flag;
@@ -121,46 +367,85 @@ void recevoir_message(Salle salles[]) {
         }
         printf("message reçu par le client %d\n", msg.pid);
 
-        char log_msg[100];
-        for (int i = 0; i < 4; i++) {
-            if (msg.film_id == salles[i].film_id) {
-                if (msg.age < salles[i].age_limite) {
-                    // Si le client est trop jeune, envoyer une confirmation avec un code d'erreur
-                    snprintf(log_msg, sizeof(log_msg), "Le client %d est trop jeune pour le film\n", msg.pid);
-                    printf("Le client %d est trop jeune pour le film\n", msg.pid);
-                    log_action(log_msg);
-                    envoyer_confirmation_reservation(msg.pid, salles[i].salle_id, AGE_LIMITE);
-                } else if (salles[i].nb_places_libres > 0) {
-                    // Si la salle a des places libres, réserver une place pour le client
-                    salles[i].nb_places_libres--;
-                    salles[i].client_pid[salles[i].nb_places_libres] = msg.pid;
-                    snprintf(log_msg, sizeof(log_msg), "Client %d a réservé une place dans la salle %d\n", msg.pid, salles[i].salle_id);
-                    printf("Client %d a réservé une place dans la salle %d\n", msg.pid, salles[i].salle_id);
-                    log_action(log_msg);
-                    envoyer_confirmation_reservation(msg.pid, salles[i].salle_id, RESERVATION_OK);
-                } else {
-                    // Si la salle est pleine, envoyer une confirmation avec un code d'erreur
-                    snprintf(log_msg, sizeof(log_msg), "La salle %d est pleine\n", salles[i].salle_id);
-                    printf("La salle %d est pleine\n", salles[i].salle_id);
-                    log_action(log_msg);
-                    envoyer_confirmation_reservation(msg.pid, salles[i].salle_id, SALLE_PLEINE);
-                }
-                break;
+        traiter_reservation(salles, nb_salles, &msg);
+    }
+}
+
+// Fonction pour traiter une demande de réservation et répondre au client
+// (renvoie la confirmation encodée, ou -1 si aucune salle ne projette le film)
+int traiter_reservation(Salle salles[], int nb_salles, struct message *msg) {
+    char log_msg[100];
+    int i = trouver_salle(salles, nb_salles, msg->film_id);
+    if (i < 0) {
+        return -1;
+    }
+    ReservationStatus status;
+    if (msg->age < salles[i].age_limite) {
+        // Si le client est trop jeune, envoyer une confirmation avec un code d'erreur
+        snprintf(log_msg, sizeof(log_msg), "Le client %d est trop jeune pour le film\n", msg->pid);
+        printf("Le client %d est trop jeune pour le film\n", msg->pid);
+        status = AGE_LIMITE;
+    } else if (attribuer_place(&salles[i], msg->pid)) {
+        // Si la salle avait des places libres, une place a été réservée pour le client
+        // (la place attribuée est la dernière libre, numérotée par rangée)
+        int places_par_rangee = salles[i].nb_places / salles[i].nb_rangees;
+        int rangee = salles[i].nb_places_libres / places_par_rangee + 1;
+        int place = salles[i].nb_places_libres % places_par_rangee + 1;
+        snprintf(log_msg, sizeof(log_msg), "Client %d a réservé la place %d-%d dans la salle %d\n", msg->pid, rangee, place, salles[i].salle_id);
+        printf("Client %d a réservé la place %d-%d dans la salle %d\n", msg->pid, rangee, place, salles[i].salle_id);
+        status = RESERVATION_OK;
+    } else {
+        // Si la salle est pleine, envoyer une confirmation avec un code d'erreur
+        snprintf(log_msg, sizeof(log_msg), "La salle %d est pleine\n", salles[i].salle_id);
+        printf("La salle %d est pleine\n", salles[i].salle_id);
+        status = SALLE_PLEINE;
+    }
+    log_action(log_msg);
+    envoyer_confirmation_reservation(msg->pid, salles[i].salle_id, status);
+    return encoder_confirmation(salles[i].salle_id, status);
+}
+
+// Fonction pour trouver la salle qui projette un film, de préférence une salle qui a encore
+// des places libres (renvoie la première salle du film si toutes sont pleines, -1 si aucune)
+int trouver_salle(Salle salles[], int nb_salles, int film_id) {
+    int premiere_salle = -1;
+    for (int i = 0; i < nb_salles; i++) {
+        if (salles[i].film_id == film_id) {
+            if (salles[i].nb_places_libres > 0) {
+                return i;
+            }
+            if (premiere_salle < 0) {
+                premiere_salle = i;
             }
         }
     }
+    return premiere_salle;
 }
 
-// Fonction pour envoyer une confirmation de réservation à un client
-void envoyer_confirmation_reservation(pid_t client_pid, int salle_id, ReservationStatus status) {
-    union sigval valeur;
+// Fonction pour attribuer une place libre à un client (renvoie false si la salle est pleine)
+bool attribuer_place(Salle *salle, pid_t client_pid) {
+    if (salle->nb_places_libres <= 0) {
+        return false;
+    }
+    salle->nb_places_libres--;
+    salle->client_pid[salle->nb_places_libres] = client_pid;
+    return true;
+}
+
+// Fonction pour encoder la réponse envoyée au client dans la valeur du signal
+int encoder_confirmation(int salle_id, ReservationStatus status) {
     if (status == AGE_LIMITE) {
-        valeur.sival_int = 999; // Envoi d'une erreur
+        return 999; // Envoi d'une erreur
     } else if(status == SALLE_PLEINE) {
-        valeur.sival_int = 888; // Envoi d'une erreur
-    } else {
-        valeur.sival_int = salle_id; // Envoi de l'ID de réservation
+        return 888; // Envoi d'une erreur
     }
+    return salle_id; // Envoi de l'ID de réservation
+}
+
+// Fonction pour envoyer une confirmation de réservation à un client
+void envoyer_confirmation_reservation(pid_t client_pid, int salle_id, ReservationStatus status) {
+    union sigval valeur;
+    valeur.sival_int = encoder_confirmation(salle_id, status);
 
     // Envoi du signal
     if (sigqueue(client_pid, SIGUSR1, valeur) == -1) {
@@ -189,8 +474,14 @@ void envoyer_signal_avec_cle(pid_t client_pid, int cle_salle, int type_evenement
 // Processus de chaque salle
 void salle_process(Salle salle) {
     while (1) {
-        printf("Attendre 30 secondes pour la prochaine projection dans la salle %d\n", salle.salle_id);
-        sleep(30);
+        // Projection à l'heure de la prochaine séance du catalogue, ou toutes les 30 secondes
+        // si la salle n'a pas de séance
+        int attente = attente_prochaine_seance(salle.salle_id);
+        if (attente < 0) {
+            attente = 30;
+        }
+        printf("Attendre %d secondes pour la prochaine projection dans la salle %d\n", attente, salle.salle_id);
+        sleep(attente);
 
         // Envoyer signal de début de projection
         for (int i = 0; i < salle.nb_places - salle.nb_places_libres; i++) {
@@ -209,7 +500,30 @@ void salle_process(Salle salle) {
         // Réinitialiser la salle
         reset_salle(&salle);
     }
-    free(salle.client_pid);
+    delete_salle(&salle);
+}
+
+// Fonction pour calculer le nombre de secondes avant la prochaine séance d'une salle
+// (renvoie -1 si le catalogue ne prévoit aucune séance pour cette salle)
+int attente_prochaine_seance(int salle_id) {
+    time_t t = time(NULL);
+    struct tm *heure_locale = localtime(&t);
+    int maintenant = heure_locale->tm_hour * 3600 + heure_locale->tm_min * 60 + heure_locale->tm_sec;
+    int attente_min = -1;
+
+    for (int i = 0; i < nb_seances; i++) {
+        if (seances[i].salle_id != salle_id) {
+            continue;
+        }
+        int attente = seances[i].heure * 60 - maintenant;
+        if (attente < 0) {
+            attente += 24 * 3600; // Séance déjà passée : celle du lendemain
+        }
+        if (attente_min < 0 || attente < attente_min) {
+            attente_min = attente;
+        }
+    }
+    return attente_min;
 }
 
 // Fonction pour réinitialiser une salle
@@ -226,11 +540,208 @@ void reset_salle(Salle *salle) {
 //Fonction pour supprimer une salle
 void delete_salle(Salle *salle) {
     if (salle->client_pid != NULL) {
-        free(salle->client_pid);
+        // Les places prises dans l'arène sont libérées avec elle par liberer_catalogue
+        if (!salle->places_arena) {
+            free(salle->client_pid);
+        }
         salle->client_pid = NULL; // Assurez-vous que le pointeur ne pointe plus sur une zone mémoire libérée
     }
 }
 
+// Fonction pour recevoir les requêtes du routeur sur la socket UNIX du site
+void servir_site(int numero_site) {
+    struct sockaddr_un adresse;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    socket_site = fd;
+    if (fd < 0) {
+        perror("Erreur lors de la création de la socket du site");
+        exit(1);
+    }
+
+    memset(&adresse, 0, sizeof(adresse));
+    adresse.sun_family = AF_UNIX;
+    snprintf(chemin_socket, sizeof(chemin_socket), CHEMIN_SOCKET_SITE, numero_site);
+    snprintf(adresse.sun_path, sizeof(adresse.sun_path), "%s", chemin_socket);
+    unlink(chemin_socket);
+    if (bind(fd, (struct sockaddr *)&adresse, sizeof(adresse)) < 0 || listen(fd, 16) < 0) {
+        perror("Erreur lors de l'ouverture de la socket du site");
+        exit(1);
+    }
+    printf("Site %d en attente du routeur sur %s\n", numero_site, chemin_socket);
+
+    // Une requête par connexion, traitées les unes après les autres
+    while (true) {
+        int connexion = accept(fd, NULL, NULL);
+        if (connexion < 0) {
+            perror("Erreur lors de l'acceptation d'une connexion");
+            continue;
+        }
+        connexion_site = connexion;
+        traiter_requete_site(connexion);
+        close(connexion);
+        connexion_site = -1;
+    }
+}
+
+// Fonction pour traiter une requête du routeur et lui répondre
+void traiter_requete_site(int connexion) {
+    struct requete_site requete;
+    struct reponse_site reponse;
+    char log_msg[100];
+    memset(&reponse, 0, sizeof(reponse));
+
+    if (lire_tout(connexion, &requete, sizeof(requete)) < 0) {
+        perror("Erreur lors de la lecture de la requête du routeur");
+        return;
+    }
+
+    switch (requete.type) {
+        case REQUETE_RESERVATION:
+            printf("message reçu par le client %d\n", requete.msg.pid);
+            reponse.code = traiter_reservation(salles, nb_salles, &requete.msg);
+            ecrire_tout(connexion, &reponse, sizeof(reponse));
+            break;
+
+        case REQUETE_DISPONIBILITE:
+            // Réponse suivie de l'état de chaque salle du site
+            reponse.nb_salles = nb_salles;
+            ecrire_tout(connexion, &reponse, sizeof(reponse));
+            for (int i = 0; i < nb_salles; i++) {
+                EtatSalle etat = etat_salle(&salles[i]);
+                ecrire_tout(connexion, &etat, sizeof(etat));
+            }
+            break;
+
+        case REQUETE_RETIRER_SALLE: {
+            int i = 0;
+            while (i < nb_salles && salles[i].salle_id != requete.salle_id) {
+                i++;
+            }
+            if (i == nb_salles) {
+                reponse.code = -1;
+                ecrire_tout(connexion, &reponse, sizeof(reponse));
+                break;
+            }
+
+            // Arrêter le processus de la salle
+            if (salles[i].pid_processus > 0) {
+                kill(salles[i].pid_processus, SIGTERM);
+                waitpid(salles[i].pid_processus, NULL, 0);
+            }
+            snprintf(log_msg, sizeof(log_msg), "Salle %d retirée du site\n", salles[i].salle_id);
+            printf("Salle %d retirée du site\n", salles[i].salle_id);
+            log_action(log_msg);
+
+            // Réponse suivie des places de la salle, pour que le site destinataire la reprenne telle quelle
+            reponse.etat = etat_salle(&salles[i]);
+            ecrire_tout(connexion, &reponse, sizeof(reponse));
+            ecrire_tout(connexion, salles[i].client_pid, salles[i].nb_places * sizeof(int));
+
+            // Libérer la place de la salle dans le tableau
+            delete_salle(&salles[i]);
+            salles[i] = salles[--nb_salles];
+            break;
+        }
+
+        case REQUETE_AJOUTER_SALLE: {
+            if (requete.etat.nb_places <= 0) {
+                reponse.code = -1;
+                ecrire_tout(connexion, &reponse, sizeof(reponse));
+                break;
+            }
+            Salle salle = create_salle(requete.etat.salle_id, requete.etat.nb_places, requete.etat.film_id, requete.etat.age_limite);
+            if (lire_tout(connexion, salle.client_pid, salle.nb_places * sizeof(int)) < 0) {
+                perror("Erreur lors de la lecture des places de la salle");
+                delete_salle(&salle);
+                return;
+            }
+
+            // Refuser un nombre de places libres incohérent ou une salle déjà présente sur le site
+            bool salle_valide = requete.etat.nb_places_libres >= 0 && requete.etat.nb_places_libres <= salle.nb_places;
+            for (int i = 0; i < nb_salles && salle_valide; i++) {
+                if (salles[i].salle_id == salle.salle_id) {
+                    salle_valide = false;
+                }
+            }
+            if (!salle_valide) {
+                delete_salle(&salle);
+                reponse.code = -1;
+                ecrire_tout(connexion, &reponse, sizeof(reponse));
+                break;
+            }
+
+            if (nb_salles == capacite_salles) {
+                Salle *agrandi = realloc(salles, 2 * capacite_salles * sizeof(Salle));
+                if (agrandi == NULL) {
+                    delete_salle(&salle);
+                    reponse.code = -1;
+                    ecrire_tout(connexion, &reponse, sizeof(reponse));
+                    break;
+                }
+                salles = agrandi;
+                capacite_salles *= 2;
+            }
+            salle.nb_places_libres = requete.etat.nb_places_libres;
+            if (requete.etat.nb_rangees > 0 && salle.nb_places % requete.etat.nb_rangees == 0) {
+                salle.nb_rangees = requete.etat.nb_rangees;
+            }
+            lancer_salle(&salle);
+            salles[nb_salles++] = salle;
+            ecrire_tout(connexion, &reponse, sizeof(reponse));
+
+            snprintf(log_msg, sizeof(log_msg), "Salle %d ajoutée au site\n", salle.salle_id);
+            printf("Salle %d ajoutée au site\n", salle.salle_id);
+            log_action(log_msg);
+            break;
+        }
+
+        default:
+            reponse.code = -1;
+            ecrire_tout(connexion, &reponse, sizeof(reponse));
+            break;
+    }
+}
+
+// Fonction pour obtenir l'état d'une salle à envoyer au routeur
+EtatSalle etat_salle(Salle *salle) {
+    EtatSalle etat;
+    etat.salle_id = salle->salle_id;
+    etat.nb_places = salle->nb_places;
+    etat.nb_places_libres = salle->nb_places_libres;
+    etat.film_id = salle->film_id;
+    etat.age_limite = salle->age_limite;
+    etat.nb_rangees = salle->nb_rangees;
+    return etat;
+}
+
+// Fonction pour lire exactement taille octets sur une socket
+int lire_tout(int fd, void *buffer, size_t taille) {
+    char *octets = buffer;
+    while (taille > 0) {
+        ssize_t lus = read(fd, octets, taille);
+        if (lus <= 0) {
+            return -1;
+        }
+        octets += lus;
+        taille -= lus;
+    }
+    return 0;
+}
+
+// Fonction pour écrire exactement taille octets sur une socket
+int ecrire_tout(int fd, const void *buffer, size_t taille) {
+    const char *octets = buffer;
+    while (taille > 0) {
+        ssize_t ecrits = send(fd, octets, taille, MSG_NOSIGNAL);
+        if (ecrits < 0) {
+            return -1;
+        }
+        octets += ecrits;
+        taille -= ecrits;
+    }
+    return 0;
+}
+
 // Fonction pour enregistrer une action dans le fichier de log
 void log_action(const char *message) {
     // Ouvrir le fichier de log en mode append
@@ -261,9 +772,15 @@ void handle_sigint(int sig) {
     printf("Signal SIGINT reçu, arrêt du programme...\n");
 
     // Libérer la mémoire allouée pour les salles
-    for (int i = 0; i < 4; i++) {
+    for (int i = 0; i < nb_salles; i++) {
         delete_salle(&salles[i]);
     }
+    liberer_catalogue();
+
+    // Supprimer la socket du site
+    if (chemin_socket[0] != '\0') {
+        unlink(chemin_socket);
+    }
 
     // Terminer le programme
     exit(0);
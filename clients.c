@@ -12,7 +12,9 @@
 #include <sys/shm.h>
 #include <sys/sem.h>
 
+#ifndef NUM_CLIENTS
 #define NUM_CLIENTS 3
+#endif
 #define SHM_KEY 1234
 #define SEM_KEY 5678
 
@@ -42,6 +44,7 @@ volatile sig_atomic_t cleanup_done = 0;
 // Prototypes des fonctions
 Client create_client(int id, int age);
 bool reserver_film(Client *client);
+Client *trouver_client(SharedData *shared_data, int pid);
 void gestionnaire_signal(int sig, siginfo_t *info, void *context);
 void reset_client(Client *client);
 void log_action(const char *message);
@@ -58,6 +61,7 @@ void wait_semaphore(int semid);
 void signal_semaphore(int semid);
 void remove_semaphore(int semid);
 
+#ifndef SANS_MAIN
 int main(void) {
     struct sigaction sa;
     sa.sa_handler = handle_sigint;
@@ -119,6 +123,7 @@ int main(void) {
 
     return 0;
 }
+#endif
 
 // Fonction pour la création d'un nouveau client
 Client create_client(int id, int age) {
@@ -214,13 +219,7 @@ void gestionnaire_signal(int sig, siginfo_t *info, void *context) {
     attach_shared_memory(shmid, &shared_data);
 
     // Find the client corresponding to the PID
-    Client *client = NULL;
-    for (int i = 0; i < NUM_CLIENTS; i++) {
-        if (shared_data->clients[i].id == client_pid) {
-            client = &shared_data->clients[i];
-            break;
-        }
-    }
+    Client *client = trouver_client(shared_data, client_pid);
 
     // If the client is not found, display an error and return
     if (client == NULL) {
@@ -285,6 +284,16 @@ void gestionnaire_signal(int sig, siginfo_t *info, void *context) {
     detach_shared_memory(shared_data);
 }
 
+// Fonction pour retrouver un client dans la mémoire partagée à partir de son PID
+Client *trouver_client(SharedData *shared_data, int pid) {
+    for (int i = 0; i < NUM_CLIENTS; i++) {
+        if (shared_data->clients[i].id == pid) {
+            return &shared_data->clients[i];
+        }
+    }
+    return NULL;
+}
+
 // Fonction pour réinitialiser un client
 void reset_client(Client *client) {
     client->film_id = rand() % 3; // Choisir un nouveau film aléatoire
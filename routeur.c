@@ -0,0 +1,558 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <sys/ipc.h>
+#include <sys/msg.h>
+#include <sys/sem.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+
+#include "site.h"
+
+#define NB_SITES_MAX 16
+#define NB_ROUTES_MAX 4096
+#define DELAI_SITE 5 // Délai maximal d'attente d'un site, en secondes
+
+// Structure pour représenter l'emplacement d'une salle
+typedef struct {
+    int salle_id;
+    int film_id;
+    int site;
+    int nb_places_libres;
+} Route;
+
+// Structure pour la table de routage, partagée entre le routage des messages et la console
+typedef struct {
+    int nb_routes;
+    Route routes[NB_ROUTES_MAX];
+} TableRoutage;
+
+int sites[NB_SITES_MAX];
+int nb_sites = 0;
+TableRoutage *table = NULL;
+int semid = -1;
+pid_t pid_routeur;
+
+volatile sig_atomic_t cleanup_done = 0;
+
+// Prototypes des fonctions
+void router_messages(void);
+int transmettre_reservation(struct message *msg);
+void console_routeur(void);
+int actualiser_table(bool afficher);
+int site_du_film(int film_id);
+void noter_reservation(int site, int film_id, int code);
+int deplacer_salle(int salle_id, int site_destination);
+void equilibrer_sites(void);
+int envoyer_requete(int site, struct requete_site *requete, struct reponse_site *reponse);
+int ajouter_salle(int site, EtatSalle *etat, int *client_pid);
+int connecter_site(int site);
+bool site_connu(int site);
+int lire_tout(int fd, void *buffer, size_t taille);
+int ecrire_tout(int fd, const void *buffer, size_t taille);
+void log_action(const char *message);
+void handle_sigint(int sig);
+void init_semaphore(int *semid);
+void wait_semaphore(int semid);
+void signal_semaphore(int semid);
+void remove_semaphore(int semid);
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage : %s <numero_site> [<numero_site>...]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 1; i < argc && nb_sites < NB_SITES_MAX; i++) {
+        sites[nb_sites++] = atoi(argv[i]);
+    }
+
+    pid_routeur = getpid();
+    struct sigaction sa;
+    sa.sa_handler = handle_sigint;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGINT, &sa, NULL);
+
+    // Table de routage en mémoire partagée, protégée par un sémaphore
+    table = mmap(NULL, sizeof(TableRoutage), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (table == MAP_FAILED) {
+        perror("Erreur lors de la création de la table de routage");
+        exit(1);
+    }
+    init_semaphore(&semid);
+
+    wait_semaphore(semid);
+    actualiser_table(true);
+    signal_semaphore(semid);
+
+    // Processus de la console d'administration (disponibilités, rééquilibrage)
+    fflush(stdout); // Sinon la console réécrit la table déjà affichée
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        exit(1);
+    } else if (pid == 0) {
+        console_routeur();
+        exit(0);
+    }
+
+    router_messages();
+    return 0;
+}
+
+// Fonction pour transmettre les messages des clients au site qui projette le film demandé
+void router_messages(void) {
+    int msgid, flag;
+    key_t key1 = 17;
+    flag = IPC_CREAT | 0666;
+    struct message msg;
+    char log_msg[100];
+
+    // Création de la file de messages
+    msgid = msgget(key1, flag);
+    if (msgid < 0) {
+        perror("Erreur lors de la création de la file de messages");
+        exit(1);
+    }
+
+    while (true) {
+        // Réception du message
+        if (msgrcv(msgid, &msg, sizeof(msg) - sizeof(long), 2, MSG_NOERROR) < 0) {
+            perror("Erreur lors de la réception du message");
+            continue;
+        }
+
+        // Le sémaphore empêche de router vers une salle en cours de déplacement
+        wait_semaphore(semid);
+        int code = transmettre_reservation(&msg);
+        if (code == -1) {
+            // Route absente ou périmée (site démarré après le routeur, salle déplacée) :
+            // reconstruire la table et réessayer une fois
+            actualiser_table(false);
+            code = transmettre_reservation(&msg);
+        }
+        if (code == -1) {
+            snprintf(log_msg, sizeof(log_msg), "Aucun site ne projette le film %d demandé par le client %d\n", msg.film_id, msg.pid);
+            printf("Aucun site ne projette le film %d demandé par le client %d\n", msg.film_id, msg.pid);
+            log_action(log_msg);
+        } else if (code == -2) {
+            snprintf(log_msg, sizeof(log_msg), "Demande du client %d non transmise : site injoignable\n", msg.pid);
+            printf("Demande du client %d non transmise : site injoignable\n", msg.pid);
+            log_action(log_msg);
+        }
+        signal_semaphore(semid);
+    }
+}
+
+// Fonction pour transmettre une demande de réservation au site qui projette le film
+// (renvoie la confirmation encodée par le site, -1 si aucun site ne projette le film,
+// -2 si le site est injoignable)
+int transmettre_reservation(struct message *msg) {
+    int site = site_du_film(msg->film_id);
+    if (site < 0) {
+        return -1;
+    }
+
+    struct requete_site requete;
+    struct reponse_site reponse;
+    memset(&requete, 0, sizeof(requete));
+    requete.type = REQUETE_RESERVATION;
+    requete.msg = *msg;
+    int fd = envoyer_requete(site, &requete, &reponse);
+    if (fd < 0) {
+        return -2;
+    }
+    close(fd);
+    if (reponse.code >= 0) {
+        printf("Message du client %d transmis au site %d\n", msg->pid, site);
+        noter_reservation(site, msg->film_id, reponse.code);
+    }
+    return reponse.code;
+}
+
+// Console d'administration lue sur l'entrée standard
+void console_routeur(void) {
+    char ligne[100];
+    int salle_id, site;
+
+    printf("Commandes : dispo | deplacer <salle> <site> | equilibrer\n");
+    while (fgets(ligne, sizeof(ligne), stdin) != NULL) {
+        wait_semaphore(semid);
+        if (strncmp(ligne, "dispo", 5) == 0) {
+            actualiser_table(true);
+        } else if (sscanf(ligne, "deplacer %d %d", &salle_id, &site) == 2) {
+            actualiser_table(false);
+            if (deplacer_salle(salle_id, site) < 0) {
+                printf("Impossible de déplacer la salle %d vers le site %d\n", salle_id, site);
+            }
+        } else if (strncmp(ligne, "equilibrer", 10) == 0) {
+            actualiser_table(false);
+            equilibrer_sites();
+        } else {
+            printf("Commandes : dispo | deplacer <salle> <site> | equilibrer\n");
+        }
+        signal_semaphore(semid);
+    }
+}
+
+// Fonction pour reconstruire la table de routage à partir des disponibilités de chaque site
+// (renvoie le nombre de salles trouvées)
+int actualiser_table(bool afficher) {
+    int total_places = 0, total_libres = 0;
+    table->nb_routes = 0;
+
+    if (afficher) {
+        printf("%-6s %-6s %-6s %s\n", "site", "salle", "film", "places libres");
+    }
+    for (int s = 0; s < nb_sites; s++) {
+        struct requete_site requete;
+        struct reponse_site reponse;
+        memset(&requete, 0, sizeof(requete));
+        requete.type = REQUETE_DISPONIBILITE;
+        int fd = envoyer_requete(sites[s], &requete, &reponse);
+        if (fd < 0) {
+            continue;
+        }
+        for (int i = 0; i < reponse.nb_salles; i++) {
+            EtatSalle etat;
+            if (lire_tout(fd, &etat, sizeof(etat)) < 0) {
+                perror("Erreur lors de la lecture des disponibilités");
+                break;
+            }
+            if (table->nb_routes < NB_ROUTES_MAX) {
+                Route *route = &table->routes[table->nb_routes++];
+                route->salle_id = etat.salle_id;
+                route->film_id = etat.film_id;
+                route->site = sites[s];
+                route->nb_places_libres = etat.nb_places_libres;
+            }
+            total_places += etat.nb_places;
+            total_libres += etat.nb_places_libres;
+            if (afficher) {
+                printf("%-6d %-6d %-6d %d/%d\n", sites[s], etat.salle_id, etat.film_id, etat.nb_places_libres, etat.nb_places);
+            }
+        }
+        close(fd);
+    }
+    if (afficher) {
+        printf("Total : %d/%d places libres dans %d salles\n", total_libres, total_places, table->nb_routes);
+    }
+    return table->nb_routes;
+}
+
+// Fonction pour trouver le site qui projette un film, de préférence dans une salle
+// qui a encore des places libres (renvoie -1 si aucun)
+int site_du_film(int film_id) {
+    int premier_site = -1;
+    for (int i = 0; i < table->nb_routes; i++) {
+        if (table->routes[i].film_id == film_id) {
+            if (table->routes[i].nb_places_libres > 0) {
+                return table->routes[i].site;
+            }
+            if (premier_site < 0) {
+                premier_site = table->routes[i].site;
+            }
+        }
+    }
+    return premier_site;
+}
+
+// Fonction pour mettre à jour les places libres de la table après la réponse d'un site
+void noter_reservation(int site, int film_id, int code) {
+    for (int i = 0; i < table->nb_routes; i++) {
+        Route *route = &table->routes[i];
+        if (route->site != site || route->film_id != film_id) {
+            continue;
+        }
+        if (code == 888) {
+            // Salle pleine : le site n'a plus de place pour ce film
+            route->nb_places_libres = 0;
+        } else if (code != 999 && route->salle_id == code && route->nb_places_libres > 0) {
+            route->nb_places_libres--;
+        }
+    }
+}
+
+// Fonction pour déplacer une salle, avec ses places réservées, vers un autre site
+int deplacer_salle(int salle_id, int site_destination) {
+    char log_msg[100];
+    Route *route = NULL;
+    for (int i = 0; i < table->nb_routes; i++) {
+        if (table->routes[i].salle_id == salle_id) {
+            route = &table->routes[i];
+            break;
+        }
+    }
+    if (route == NULL || !site_connu(site_destination)) {
+        return -1;
+    }
+    if (route->site == site_destination) {
+        return 0;
+    }
+
+    // Retirer la salle du site source, qui renvoie son état et ses places
+    struct requete_site requete;
+    struct reponse_site reponse;
+    memset(&requete, 0, sizeof(requete));
+    requete.type = REQUETE_RETIRER_SALLE;
+    requete.salle_id = salle_id;
+    int fd = envoyer_requete(route->site, &requete, &reponse);
+    if (fd < 0) {
+        return -1;
+    }
+    if (reponse.code < 0) {
+        close(fd);
+        return -1;
+    }
+    EtatSalle etat = reponse.etat;
+    int *client_pid = malloc(etat.nb_places * sizeof(int));
+    if (client_pid == NULL || lire_tout(fd, client_pid, etat.nb_places * sizeof(int)) < 0) {
+        perror("Erreur lors de la lecture des places de la salle");
+        close(fd);
+        free(client_pid);
+        return -1;
+    }
+    close(fd);
+
+    // Ajouter la salle au site destination, ou la rendre au site source en cas d'échec
+    int site_final = site_destination;
+    if (ajouter_salle(site_destination, &etat, client_pid) < 0) {
+        site_final = route->site;
+        if (ajouter_salle(route->site, &etat, client_pid) < 0) {
+            snprintf(log_msg, sizeof(log_msg), "Salle %d perdue lors du déplacement\n", salle_id);
+            printf("Salle %d perdue lors du déplacement\n", salle_id);
+            log_action(log_msg);
+            free(client_pid);
+            return -1;
+        }
+    }
+    free(client_pid);
+
+    if (site_final != site_destination) {
+        return -1;
+    }
+    snprintf(log_msg, sizeof(log_msg), "Salle %d déplacée du site %d vers le site %d\n", salle_id, route->site, site_destination);
+    printf("Salle %d déplacée du site %d vers le site %d\n", salle_id, route->site, site_destination);
+    log_action(log_msg);
+    route->site = site_destination;
+    return 0;
+}
+
+// Fonction pour répartir les salles entre les sites (écart d'au plus une salle)
+void equilibrer_sites(void) {
+    while (true) {
+        int nb_salles_site[NB_SITES_MAX] = {0};
+        int plus_charge = 0, moins_charge = 0;
+        for (int i = 0; i < table->nb_routes; i++) {
+            for (int s = 0; s < nb_sites; s++) {
+                if (sites[s] == table->routes[i].site) {
+                    nb_salles_site[s]++;
+                }
+            }
+        }
+        for (int s = 1; s < nb_sites; s++) {
+            if (nb_salles_site[s] > nb_salles_site[plus_charge]) {
+                plus_charge = s;
+            }
+            if (nb_salles_site[s] < nb_salles_site[moins_charge]) {
+                moins_charge = s;
+            }
+        }
+        if (nb_salles_site[plus_charge] - nb_salles_site[moins_charge] <= 1) {
+            break;
+        }
+
+        // Déplacer une salle du site le plus chargé vers le moins chargé
+        int salle_id = -1;
+        for (int i = 0; i < table->nb_routes; i++) {
+            if (table->routes[i].site == sites[plus_charge]) {
+                salle_id = table->routes[i].salle_id;
+                break;
+            }
+        }
+        if (salle_id < 0 || deplacer_salle(salle_id, sites[moins_charge]) < 0) {
+            printf("Rééquilibrage interrompu\n");
+            break;
+        }
+    }
+    printf("Sites équilibrés\n");
+}
+
+// Fonction pour envoyer une requête à un site et lire l'en-tête de sa réponse
+// (renvoie la connexion, à fermer par l'appelant, ou -1 en cas d'erreur)
+int envoyer_requete(int site, struct requete_site *requete, struct reponse_site *reponse) {
+    int fd = connecter_site(site);
+    if (fd < 0) {
+        return -1;
+    }
+    if (ecrire_tout(fd, requete, sizeof(*requete)) < 0 || lire_tout(fd, reponse, sizeof(*reponse)) < 0) {
+        perror("Erreur lors de l'échange avec le site");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Fonction pour ajouter une salle et ses places à un site
+int ajouter_salle(int site, EtatSalle *etat, int *client_pid) {
+    struct requete_site requete;
+    struct reponse_site reponse;
+    memset(&requete, 0, sizeof(requete));
+    requete.type = REQUETE_AJOUTER_SALLE;
+    requete.salle_id = etat->salle_id;
+    requete.etat = *etat;
+
+    int fd = connecter_site(site);
+    if (fd < 0) {
+        return -1;
+    }
+    if (ecrire_tout(fd, &requete, sizeof(requete)) < 0
+        || ecrire_tout(fd, client_pid, etat->nb_places * sizeof(int)) < 0
+        || lire_tout(fd, &reponse, sizeof(reponse)) < 0) {
+        perror("Erreur lors de l'ajout de la salle");
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    return reponse.code;
+}
+
+// Fonction pour se connecter à la socket UNIX d'un site
+int connecter_site(int site) {
+    struct sockaddr_un adresse;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("Erreur lors de la création de la socket");
+        return -1;
+    }
+
+    // Un site bloqué ne doit pas bloquer le routeur, qui détient le sémaphore
+    struct timeval delai = {DELAI_SITE, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &delai, sizeof(delai));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &delai, sizeof(delai));
+
+    memset(&adresse, 0, sizeof(adresse));
+    adresse.sun_family = AF_UNIX;
+    snprintf(adresse.sun_path, sizeof(adresse.sun_path), CHEMIN_SOCKET_SITE, site);
+    if (connect(fd, (struct sockaddr *)&adresse, sizeof(adresse)) < 0) {
+        fprintf(stderr, "Site %d injoignable sur %s\n", site, adresse.sun_path);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Fonction pour vérifier qu'un site fait partie de ceux gérés par le routeur
+bool site_connu(int site) {
+    for (int s = 0; s < nb_sites; s++) {
+        if (sites[s] == site) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Fonction pour lire exactement taille octets sur une socket
+int lire_tout(int fd, void *buffer, size_t taille) {
+    char *octets = buffer;
+    while (taille > 0) {
+        ssize_t lus = read(fd, octets, taille);
+        if (lus <= 0) {
+            return -1;
+        }
+        octets += lus;
+        taille -= lus;
+    }
+    return 0;
+}
+
+// Fonction pour écrire exactement taille octets sur une socket
+int ecrire_tout(int fd, const void *buffer, size_t taille) {
+    const char *octets = buffer;
+    while (taille > 0) {
+        ssize_t ecrits = send(fd, octets, taille, MSG_NOSIGNAL);
+        if (ecrits < 0) {
+            return -1;
+        }
+        octets += ecrits;
+        taille -= ecrits;
+    }
+    return 0;
+}
+
+// Fonction pour enregistrer une action dans le fichier de log
+void log_action(const char *message) {
+    // Ouvrir le fichier de log en mode append
+    FILE *log_file = fopen("log.txt", "a");
+    if (log_file != NULL) {
+        struct flock lock;
+        lock.l_type = F_WRLCK;
+        lock.l_whence = SEEK_SET;
+        lock.l_start = 0;
+        lock.l_len = 0;
+        fcntl(fileno(log_file), F_SETLKW, &lock); // Verrouillez le fichier
+        fprintf(log_file, "%s", message);
+        lock.l_type = F_UNLCK;
+        fcntl(fileno(log_file), F_SETLK, &lock); // Déverrouillez le fichier
+        fclose(log_file);
+    } else {
+        perror("Erreur lors de l'ouverture du fichier de log");
+    }
+}
+
+// Gestionnaire de signal pour SIGINT
+void handle_sigint(int sig) {
+    if (cleanup_done) {
+        return;
+    }
+    cleanup_done = 1;
+
+    // Seul le processus principal supprime le sémaphore
+    if (getpid() == pid_routeur) {
+        printf("Signal SIGINT reçu, arrêt du routeur...\n");
+        remove_semaphore(semid);
+    }
+    exit(0);
+}
+
+// Fonction pour initialiser le sémaphore
+void init_semaphore(int *semid) {
+    *semid = semget(IPC_PRIVATE, 1, IPC_CREAT | 0600);
+    if (*semid < 0) {
+        perror("Erreur lors de la création du sémaphore");
+        exit(1);
+    }
+    if (semctl(*semid, 0, SETVAL, 1) < 0) {
+        perror("Erreur lors de l'initialisation du sémaphore");
+        exit(1);
+    }
+}
+
+// Fonction pour attendre le sémaphore
+void wait_semaphore(int semid) {
+    struct sembuf sb = {0, -1, 0};
+    if (semop(semid, &sb, 1) < 0) {
+        perror("Erreur lors de l'attente du sémaphore");
+    }
+}
+
+// Fonction pour signaler le sémaphore
+void signal_semaphore(int semid) {
+    struct sembuf sb = {0, 1, 0};
+    if (semop(semid, &sb, 1) < 0) {
+        perror("Erreur lors du signal du sémaphore");
+    }
+}
+
+// Fonction pour supprimer le sémaphore
+void remove_semaphore(int semid) {
+    if (semctl(semid, 0, IPC_RMID) < 0) {
+        perror("Erreur lors de la suppression du sémaphore");
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef SITE_H
+#define SITE_H
+
+// Protocole entre le routeur (routeur.c) et les sites (cinema.c -s) sur les sockets UNIX
+
+#define CHEMIN_SOCKET_SITE "/tmp/cinema_site_%d.sock"
+
+// Structure pour les messages échangés entre les processus
+struct message {
+    long message_type;
+    int pid;
+    int film_id;
+    int age;
+};
+
+// Types de requêtes envoyées par le routeur aux sites
+typedef enum {
+    REQUETE_RESERVATION,
+    REQUETE_DISPONIBILITE,
+    REQUETE_RETIRER_SALLE,
+    REQUETE_AJOUTER_SALLE
+} TypeRequete;
+
+// Structure pour l'état d'une salle échangé entre les sites et le routeur
+typedef struct {
+    int salle_id;
+    int nb_places;
+    int nb_places_libres;
+    int film_id;
+    int age_limite;
+    int nb_rangees;
+} EtatSalle;
+
+// Structure pour les requêtes envoyées par le routeur aux sites
+struct requete_site {
+    int type;
+    int salle_id;
+    struct message msg;
+    EtatSalle etat;
+};
+
+// Structure pour les réponses des sites au routeur
+// (code : -1 en cas d'échec ; pour une réservation, confirmation encodée envoyée au client)
+struct reponse_site {
+    int code;
+    int nb_salles;
+    EtatSalle etat;
+};
+
+#endif